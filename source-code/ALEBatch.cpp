@@ -0,0 +1,483 @@
+// File: ALEBatch.cpp
+// Lockstep execution of one program over many inputs for Assembly Language Emulator.
+
+#include <iostream>
+#include <stdexcept>
+#include "ALEBatch.h"
+#include "ALEConstants.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+ALEBatch::ALEBatch(ALEDatabase* prog_data, int lane_count) {
+    this->prog_data = prog_data;
+    this->lane_count = lane_count;
+
+    lane_memory.resize(lane_count);
+    lane_index.assign(lane_count, 0);
+    lane_calls.assign(lane_count, 0);
+    lane_status.assign(lane_count, kLaneRunning);
+    ret_values.assign(lane_count, 0);
+    err_msgs.assign(lane_count, "");
+    lane_mask.assign(lane_count, 0);
+
+    line_values.resize(lane_count);
+    left_values.resize(lane_count);
+    right_values.resize(lane_count);
+    branch_left.resize(lane_count);
+    branch_right.resize(lane_count);
+    jump_dest.resize(lane_count);
+    content_values.resize(lane_count);
+    branch_result.resize(lane_count);
+
+    // Instructions, their operands and insides of M[*] are prepared once instead
+    // of on every execution.
+    for (int i = 0; i < prog_data->GetLineCount(); i++) {
+        program_lines.push_back(prog_data->GetLineAt(i));
+
+        vector<string> &line_data = program_lines.back();
+        vector<vector<string>> segments;
+        if (line_data[0] == kJump) {
+            segments.push_back(vector<string>(line_data.begin() + 1, line_data.end()));
+        } else if (IsBranch(line_data[0]) && line_data.size() > 3) {
+            segments.push_back(vector<string>(line_data.begin() + 1, line_data.begin() + 2));
+            segments.push_back(vector<string>(line_data.begin() + 2, line_data.begin() + 3));
+            segments.push_back(vector<string>(line_data.begin() + 3, line_data.end()));
+        }
+        line_segments.push_back(segments);
+
+        for (int j = 0; j < line_data.size(); j++) {
+            if (line_data[j].find(kMemAccessPrefix) == -1) continue;
+
+            string content = line_data[j].substr(2, line_data[j].find(kMemAccessClose) - line_data[j].find(kMemAccessOpen) - 1);
+            content_data[line_data[j]] = prog_data->ParseLine(content);
+        }
+    }
+
+    register_data[kStackPointer].values.assign(lane_count, kSPInitValue);
+    register_data[kStackPointer].initialized.assign(lane_count, 1);
+}
+
+ALEBatch::~ALEBatch() {
+    // Destructor isn't needed.
+}
+
+int ALEBatch::GetLaneCount() {
+    return lane_count;
+}
+
+void ALEBatch::PutRegValue(int lane, string reg, int value) {
+    LaneRegister &reg_data = register_data[reg];
+    if (reg_data.values.size() == 0) {
+        reg_data.values.assign(lane_count, 0);
+        reg_data.initialized.assign(lane_count, 0);
+    }
+
+    reg_data.values[lane] = value;
+    reg_data.initialized[lane] = 1;
+}
+
+void ALEBatch::WriteAddr(int lane, int value, int address, int byte_count) {
+    lane_memory[lane].WriteAddr(value, address, byte_count);
+}
+
+void ALEBatch::RunProgram(bool print_mode) {
+    while (true) {
+        int index = NextIndex();
+        if (index == -1) return;
+
+        if (print_mode) prog_data->PrintLine(index);
+
+        for (int i = 0; i < lane_count; i++) line_values[i] = index * 4;
+        AssignReg(kCurrInstrPointer, line_values);
+
+        vector<string> &line_data = program_lines[index];
+        const string &identifier = line_data[0];
+
+        if (identifier == kReturn) {
+            ReturnInstr();
+        } else if (identifier == kStackPointer
+                   || identifier == kRetValue
+                   || identifier.find(kRegisterPrefix) != -1
+                   || identifier.find(kMemAccessPrefix) != -1)
+        {
+            Evaluate(line_data, line_values);
+            Advance(index + 1);
+        } else if (identifier == kCall) {
+            CallInstr(line_data, index + 1);
+        } else if (identifier == kJump) {
+            JumpInstr(index);
+        } else if (IsBranch(identifier)) {
+            BranchInstr(line_data, index);
+        } else {
+            Advance(index + 1);
+        }
+    }
+}
+
+int ALEBatch::GetLaneStatus(int lane) {
+    return lane_status[lane];
+}
+
+int ALEBatch::GetRetValue(int lane) {
+    if (lane_status[lane] != kLaneReturned) {
+        string err_msg = "> Lane " + to_string(lane) + " didn't return a value.";
+        throw err_msg;
+    }
+
+    return ret_values[lane];
+}
+
+string ALEBatch::GetErrorMessage(int lane) {
+    return err_msgs[lane];
+}
+
+// Lanes that are behind always go first, so lanes which took different branches
+// wait for each other and reconverge at the first instruction they share.
+int ALEBatch::NextIndex() {
+    int index = -1;
+
+    for (int i = 0; i < lane_count; i++) {
+        if (lane_status[i] != kLaneRunning) continue;
+
+        if (lane_index[i] < 0 || lane_index[i] >= prog_data->GetLineCount()) {
+            lane_status[i] = kLaneHalted;
+            continue;
+        }
+
+        if (index == -1 || lane_index[i] < index) index = lane_index[i];
+    }
+
+    for (int i = 0; i < lane_count; i++) {
+        lane_mask[i] = lane_status[i] == kLaneRunning && lane_index[i] == index;
+    }
+
+    return index;
+}
+
+bool ALEBatch::IsBranch(const string &identifier) {
+    for (int i = 0; i < kBranchSize; i++) {
+        if (identifier == kBranch[i]) return true;
+    }
+
+    return false;
+}
+
+void ALEBatch::Advance(int index) {
+    for (int i = 0; i < lane_count; i++) {
+        if (lane_mask[i]) lane_index[i] = index;
+    }
+}
+
+void ALEBatch::FailLane(int lane, const string &err_msg) {
+    lane_status[lane] = kLaneFailed;
+    err_msgs[lane] = err_msg;
+    lane_mask[lane] = 0;
+}
+
+void ALEBatch::ReturnInstr() {
+    LaneRegister &stack_pointer = register_data[kStackPointer];
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        if (lane_calls[i] != 0) {
+            try {
+                lane_index[i] = lane_memory[i].ReadAddr(stack_pointer.values[i], sizeof(int)) / 4;
+            } catch (string err_msg) {
+                FailLane(i, err_msg);
+                continue;
+            }
+
+            stack_pointer.values[i] += 4;
+            lane_calls[i]--;
+        } else if (stack_pointer.values[i] != kSPInitValue) {
+            FailLane(i, "> Memory leak detected.");
+        } else if (register_data.find(kRetValue) == register_data.end()
+                   || !register_data[kRetValue].initialized[i])
+        {
+            FailLane(i, "> Register \"" + kRetValue + "\" doesn't exist.");
+        } else {
+            ret_values[i] = register_data[kRetValue].values[i];
+            lane_status[i] = kLaneReturned;
+        }
+    }
+}
+
+void ALEBatch::CallInstr(vector<string> &line_data, int saved_index) {
+    int function_index;
+    try {
+        function_index = prog_data->GetFunctionIndex(line_data[1]);
+    } catch (string err_msg) {
+        for (int i = 0; i < lane_count; i++) {
+            if (lane_mask[i]) FailLane(i, err_msg);
+        }
+        return;
+    }
+
+    LaneRegister &stack_pointer = register_data[kStackPointer];
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        stack_pointer.values[i] -= 4;
+
+        try {
+            lane_memory[i].WriteAddr(saved_index * 4, stack_pointer.values[i], sizeof(int));
+        } catch (string err_msg) {
+            FailLane(i, err_msg);
+            continue;
+        }
+
+        lane_calls[i]++;
+        lane_index[i] = function_index;
+    }
+}
+
+void ALEBatch::JumpInstr(int index) {
+    Evaluate(line_segments[index][0], jump_dest);
+
+    for (int i = 0; i < lane_count; i++) {
+        if (lane_mask[i]) lane_index[i] = jump_dest[i] / 4;
+    }
+}
+
+void ALEBatch::BranchInstr(vector<string> &line_data, int index) {
+    vector<vector<string>> &segments = line_segments[index];
+    if (segments.size() != 3) {
+        for (int i = 0; i < lane_count; i++) {
+            if (lane_mask[i]) FailLane(i, "> Invalid branch instruction.");
+        }
+        return;
+    }
+
+    const string &op = line_data[0];
+    Evaluate(segments[0], branch_left);
+    Evaluate(segments[1], branch_right);
+    Evaluate(segments[2], jump_dest);
+
+    const int* left = branch_left.data();
+    const int* right = branch_right.data();
+    unsigned char* result = branch_result.data();
+
+    if (op == kLessThan) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] < right[i];
+    } else if (op == kLessEqual) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] <= right[i];
+    } else if (op == kEqual) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] == right[i];
+    } else if (op == kNotEqual) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] != right[i];
+    } else if (op == kGreaterThan) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] > right[i];
+    } else if (op == kGreaterEqual) {
+        for (int i = 0; i < lane_count; i++) result[i] = left[i] >= right[i];
+    }
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        if (result[i]) lane_index[i] = jump_dest[i] / 4;
+        else lane_index[i] = index + 1;
+    }
+}
+
+void ALEBatch::Evaluate(const vector<string> &line_data, vector<int> &values) {
+    // If we have only a number or a register.
+    if (line_data.size() == 1) {
+        ReadOperand(line_data[0], values);
+    }
+    // If current line contains only one operator(E.g. '+', '-', '*' or '/').
+    else if (line_data.size() == 3 && line_data[1] != "=") {
+        ALU(line_data[0], line_data[1], line_data[2], values);
+    }
+    // If current line contains more than one operator(E.g. '=' and '+', '-', '*' or '/').
+    else if (line_data.size() == 5) {
+        ALU(line_data[2], line_data[3], line_data[4], values);
+        AssignReg(line_data[0], values);
+    }
+    // If current line contains only one operator('=') or additional ".1" (1 byte) or ".2" (2 bytes).
+    else {
+        // Store(E.g. 'M[R1] = R2', 'M[R1 + 10] = 9', 'M[R1] =.2 R2'...).
+        if (line_data[0].find(kMemAccessPrefix) != -1) {
+            if (line_data.size() == 3) {
+                StoreInstr(line_data[0], line_data[2], sizeof(int), values);
+            } else {
+                int byte_count = line_data[2][1] - '0';
+                StoreInstr(line_data[0], line_data[3], byte_count, values);
+            }
+        }
+        // Load(E.g. 'R1 = M[R2]'...).
+        else if (line_data.size() == 3 && line_data[2].find(kMemAccessPrefix) != -1) {
+            LoadInstr(line_data[0], line_data[2], sizeof(int), values);
+        }
+        // Load(E.g. 'R1 =.1 M[R2]'...).
+        else if (line_data.size() == 4 && line_data[3].find(kMemAccessPrefix) != -1) {
+            int byte_count = line_data[2][1] - '0';
+            LoadInstr(line_data[0], line_data[3], byte_count, values);
+        }
+        // E.g 'R1 =.1 R2' or 'R1 =.2 64'.
+        else if (line_data.size() == 4) {
+            ReadOperand(line_data[3], values);
+            AssignReg(line_data[0], values);
+        }
+        // E.g 'R1 = R2' or 'R1 = 64'.
+        else {
+            ReadOperand(line_data[2], values);
+            AssignReg(line_data[0], values);
+        }
+    }
+}
+
+void ALEBatch::StoreInstr(const string &dest, const string &source, int byte_count, vector<int> &values) {
+    Evaluate(GetContent(dest), content_values);
+
+    ReadOperand(source, values);
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        try {
+            lane_memory[i].WriteAddr(values[i], content_values[i], byte_count);
+        } catch (string err_msg) {
+            FailLane(i, err_msg);
+        }
+    }
+}
+
+void ALEBatch::LoadInstr(const string &dest, const string &source, int byte_count, vector<int> &values) {
+    Evaluate(GetContent(source), content_values);
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        try {
+            values[i] = lane_memory[i].ReadAddr(content_values[i], byte_count);
+        } catch (string err_msg) {
+            FailLane(i, err_msg);
+        }
+    }
+
+    AssignReg(dest, values);
+}
+
+vector<string> &ALEBatch::GetContent(const string &component) {
+    return content_data[component];
+}
+
+// Lanes are stored contiguously and '+', '-' and '*' are computed for every lane
+// without branches, 8 lanes at a time when compiled with AVX2('-mavx2'). Results
+// of unmasked lanes are simply ignored. Unsigned arithmetic keeps overflow of
+// unmasked lanes well-defined.
+void ALEBatch::ALU(const string &left, const string &op, const string &right, vector<int> &values) {
+    ReadOperand(left, left_values);
+    ReadOperand(right, right_values);
+
+    const int* left_data = left_values.data();
+    const int* right_data = right_values.data();
+    int* result_data = values.data();
+
+    if (op[0] == kALUOperators[0]) {
+        int i = 0;
+#ifdef __AVX2__
+        for (; i + 8 <= lane_count; i += 8) {
+            __m256i left_lanes = _mm256_loadu_si256((const __m256i*)(left_data + i));
+            __m256i right_lanes = _mm256_loadu_si256((const __m256i*)(right_data + i));
+            _mm256_storeu_si256((__m256i*)(result_data + i), _mm256_add_epi32(left_lanes, right_lanes));
+        }
+#endif
+        for (; i < lane_count; i++) {
+            result_data[i] = (int)((unsigned)left_data[i] + (unsigned)right_data[i]);
+        }
+    } else if (op[0] == kALUOperators[1]) {
+        int i = 0;
+#ifdef __AVX2__
+        for (; i + 8 <= lane_count; i += 8) {
+            __m256i left_lanes = _mm256_loadu_si256((const __m256i*)(left_data + i));
+            __m256i right_lanes = _mm256_loadu_si256((const __m256i*)(right_data + i));
+            _mm256_storeu_si256((__m256i*)(result_data + i), _mm256_sub_epi32(left_lanes, right_lanes));
+        }
+#endif
+        for (; i < lane_count; i++) {
+            result_data[i] = (int)((unsigned)left_data[i] - (unsigned)right_data[i]);
+        }
+    } else if (op[0] == kALUOperators[2]) {
+        int i = 0;
+#ifdef __AVX2__
+        for (; i + 8 <= lane_count; i += 8) {
+            __m256i left_lanes = _mm256_loadu_si256((const __m256i*)(left_data + i));
+            __m256i right_lanes = _mm256_loadu_si256((const __m256i*)(right_data + i));
+            _mm256_storeu_si256((__m256i*)(result_data + i), _mm256_mullo_epi32(left_lanes, right_lanes));
+        }
+#endif
+        for (; i < lane_count; i++) {
+            result_data[i] = (int)((unsigned)left_data[i] * (unsigned)right_data[i]);
+        }
+    } else {
+        // Division is performed only on masked lanes, others may hold zeros.
+        for (int i = 0; i < lane_count; i++) {
+            if (!lane_mask[i]) continue;
+
+            if (right_data[i] == 0) {
+                FailLane(i, "> Division by zero.");
+            } else if (left_data[i] == INT_MIN && right_data[i] == -1) {
+                FailLane(i, "> Division result is out of range.");
+            } else {
+                result_data[i] = left_data[i] / right_data[i];
+            }
+        }
+    }
+}
+
+void ALEBatch::ReadOperand(const string &component, vector<int> &values) {
+    if (IsNumber(component)) {
+        int value;
+        try {
+            value = stoi(component);
+        } catch (out_of_range &err) {
+            for (int i = 0; i < lane_count; i++) {
+                if (lane_mask[i]) FailLane(i, "> Number is out of range.");
+            }
+            return;
+        }
+
+        for (int i = 0; i < lane_count; i++) values[i] = value;
+        return;
+    }
+
+    if (register_data.find(component) == register_data.end()) {
+        for (int i = 0; i < lane_count; i++) {
+            if (lane_mask[i]) FailLane(i, "> Register \"" + component + "\" doesn't exist.");
+        }
+        return;
+    }
+
+    LaneRegister &reg_data = register_data[component];
+    for (int i = 0; i < lane_count; i++) {
+        if (lane_mask[i] && !reg_data.initialized[i]) {
+            FailLane(i, "> Register \"" + component + "\" doesn't exist.");
+        }
+    }
+
+    for (int i = 0; i < lane_count; i++) values[i] = reg_data.values[i];
+}
+
+void ALEBatch::AssignReg(const string &reg, vector<int> &values) {
+    LaneRegister &reg_data = register_data[reg];
+    if (reg_data.values.size() == 0) {
+        reg_data.values.assign(lane_count, 0);
+        reg_data.initialized.assign(lane_count, 0);
+    }
+
+    for (int i = 0; i < lane_count; i++) {
+        if (!lane_mask[i]) continue;
+
+        reg_data.values[i] = values[i];
+        reg_data.initialized[i] = 1;
+    }
+}
+
+bool ALEBatch::IsNumber(const string &component) {
+    return isdigit(component[0]) || (component[0] == kALUOperators[1] && isdigit(component[1]));
+}
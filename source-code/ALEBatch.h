@@ -0,0 +1,128 @@
+// File: ALEBatch.h
+// Lockstep execution of one program over many inputs for Assembly Language Emulator.
+
+#ifndef ALEBatch_Class
+#define ALEBatch_Class
+
+#include <string>
+#include <vector>
+#include <map>
+#include "ALEDatabase.h"
+#include "ALEMemory.h"
+
+using namespace std;
+
+class ALEBatch {
+    public:
+        // Prepares 'lane_count' instances(lanes) of given program. Every lane has
+        // it's own registers, address space and error status.
+        ALEBatch(ALEDatabase* prog_data, int lane_count);
+
+        // Destructor isn't needed.
+        ~ALEBatch();
+
+        // Returns total number of lanes.
+        int GetLaneCount();
+
+        // Assigns given value to given register of the lane'th instance.
+        void PutRegValue(int lane, string reg, int value);
+
+        // Writes 'byte_count' length data of given value into given address of the
+        // lane'th instance.
+        void WriteAddr(int lane, int value, int address, int byte_count);
+
+        // Executes all lanes in lockstep until each of them returns, halts or fails.
+        void RunProgram(bool print_mode);
+
+        // Returns status of the lane'th instance(E.g. kLaneReturned or kLaneFailed).
+        int GetLaneStatus(int lane);
+
+        // Returns value of the register 'RV' at the final RET of the lane'th instance.
+        int GetRetValue(int lane);
+
+        // Returns error message of the lane'th instance, or empty string if it didn't fail.
+        string GetErrorMessage(int lane);
+    private:
+        // Values of a single register in every lane.
+        struct LaneRegister {
+            vector<int> values;
+            vector<unsigned char> initialized;
+        };
+
+        // Selects the smallest instruction index among running lanes and masks the
+        // lanes waiting on it. Returns -1 if there are no running lanes left.
+        int NextIndex();
+
+        // Checks if kBranch array contains given identifier.
+        bool IsBranch(const string &identifier);
+
+        // Moves masked lanes to the given instruction index.
+        void Advance(int index);
+
+        // Marks given lane as failed and removes it from the mask.
+        void FailLane(int lane, const string &err_msg);
+
+        // If we have return instruction this code is performed.
+        void ReturnInstr();
+
+        // If we have call instruction this code is performed.
+        void CallInstr(vector<string> &line_data, int saved_index);
+
+        // If we have jump instruction this code is performed.
+        void JumpInstr(int index);
+
+        // If we have branch instruction this code is performed.
+        void BranchInstr(vector<string> &line_data, int index);
+
+        // Same as Evaluate of the single instance emulation, but calculates the value
+        // for every masked lane and stores it in 'values'.
+        void Evaluate(const vector<string> &line_data, vector<int> &values);
+
+        // Executes store instruction on every masked lane.
+        void StoreInstr(const string &dest, const string &source, int byte_count, vector<int> &values);
+
+        // Executes load instruction on every masked lane.
+        void LoadInstr(const string &dest, const string &source, int byte_count, vector<int> &values);
+
+        // Returns parsed insides of M[*].
+        vector<string> &GetContent(const string &component);
+
+        // Evaluates specified arithmetic instruction on every lane.
+        void ALU(const string &left, const string &op, const string &right, vector<int> &values);
+
+        // Stores the value of given register or a number in every lane.
+        void ReadOperand(const string &component, vector<int> &values);
+
+        // Assigns given values to given register in every masked lane.
+        void AssignReg(const string &reg, vector<int> &values);
+
+        // Checks if given component is a number(E.g. '99' or '-10').
+        bool IsNumber(const string &component);
+
+        ALEDatabase* prog_data; // Program shared by all lanes.
+        int lane_count; // Number of lanes.
+        map<string, LaneRegister> register_data; // Registers stored as structure-of-arrays.
+        vector<ALEMemory> lane_memory; // Address space of each lane.
+        vector<int> lane_index; // Current instruction index of each lane.
+        vector<int> lane_calls; // Call depth of each lane.
+        vector<int> lane_status; // Status of each lane.
+        vector<int> ret_values; // Returned value of each lane.
+        vector<string> err_msgs; // Error message of each lane.
+        vector<unsigned char> lane_mask; // Lanes executing current instruction.
+
+        vector<vector<string>> program_lines; // Instructions copied from the database.
+        vector<vector<vector<string>>> line_segments; // Operands of jump and branch instructions.
+        map<string, vector<string>> content_data; // Parsed insides of each M[*] in the program.
+
+        // Temporary values of every lane, kept between instructions to avoid allocations.
+        vector<int> line_values;
+        vector<int> left_values;
+        vector<int> right_values;
+        vector<int> branch_left;
+        vector<int> branch_right;
+        vector<int> jump_dest;
+        vector<int> content_values;
+        vector<unsigned char> branch_result;
+};
+
+#endif
@@ -5,59 +5,133 @@
 #define ALEConstants_Interface
 
 #include <string>
+#include <string_view>
 #include <limits.h>
 
 using namespace std;
 
 // For ALEDatabase and ALEMain:
+    // Each token is defined once as a compile-time 'kEmbedded...' view, which is
+    // used by ALEEmbedded, and the runtime string is built from it.
+
     // Prefix for a comment.
-    const string kCommentPrefix = ";";
+    constexpr string_view kEmbeddedCommentPrefix = ";";
+    const string kCommentPrefix(kEmbeddedCommentPrefix);
 
     // Brackets for function declaration;
-    const string kFuncDeclOpen = "<";
-    const string kFuncDeclClose = ">";
+    constexpr string_view kEmbeddedFuncDeclOpen = "<";
+    constexpr string_view kEmbeddedFuncDeclClose = ">";
+    const string kFuncDeclOpen(kEmbeddedFuncDeclOpen);
+    const string kFuncDeclClose(kEmbeddedFuncDeclClose);
 
     // Basic register prefix.
-    const string kRegisterPrefix = "R";
+    constexpr string_view kEmbeddedRegisterPrefix = "R";
+    const string kRegisterPrefix(kEmbeddedRegisterPrefix);
 
     // Special registers.
-    const string kCurrInstrPointer = "PC";
-    const string kStackPointer = "SP";
-    const string kRetValue = "RV";
+    constexpr string_view kEmbeddedCurrInstrPointer = "PC";
+    constexpr string_view kEmbeddedStackPointer = "SP";
+    constexpr string_view kEmbeddedRetValue = "RV";
+    const string kCurrInstrPointer(kEmbeddedCurrInstrPointer);
+    const string kStackPointer(kEmbeddedStackPointer);
+    const string kRetValue(kEmbeddedRetValue);
 
     // Memory access brackets and prefix.
-    const string kMemAccessOpen = "[";
-    const string kMemAccessClose = "]";
-    const string kMemAccessPrefix = "M" + kMemAccessOpen;
+    constexpr string_view kEmbeddedMemAccessOpen = "[";
+    constexpr string_view kEmbeddedMemAccessClose = "]";
+    constexpr string_view kEmbeddedMemAccessPrefix = "M[";
+    static_assert(kEmbeddedMemAccessPrefix.substr(1) == kEmbeddedMemAccessOpen, "Prefix must end with the bracket.");
+    const string kMemAccessOpen(kEmbeddedMemAccessOpen);
+    const string kMemAccessClose(kEmbeddedMemAccessClose);
+    const string kMemAccessPrefix(kEmbeddedMemAccessPrefix);
 
     // Arithmetic operations.
-    const string kALUOperators = "+-*/";
+    constexpr string_view kEmbeddedALUOperators = "+-*/";
+    const string kALUOperators(kEmbeddedALUOperators);
 
     // Branch instructions and divider.
-    const string kLessThan = "BLT";
-    const string kLessEqual = "BLE";
-    const string kEqual = "BEQ";
-    const string kNotEqual = "BNE";
-    const string kGreaterThan = "BGT";
-    const string kGreaterEqual = "BGE";
+    constexpr string_view kEmbeddedLessThan = "BLT";
+    constexpr string_view kEmbeddedLessEqual = "BLE";
+    constexpr string_view kEmbeddedEqual = "BEQ";
+    constexpr string_view kEmbeddedNotEqual = "BNE";
+    constexpr string_view kEmbeddedGreaterThan = "BGT";
+    constexpr string_view kEmbeddedGreaterEqual = "BGE";
+    constexpr string_view kEmbeddedBranch[] = {kEmbeddedLessThan, kEmbeddedLessEqual, kEmbeddedEqual,
+                                               kEmbeddedNotEqual, kEmbeddedGreaterThan, kEmbeddedGreaterEqual};
+    const string kLessThan(kEmbeddedLessThan);
+    const string kLessEqual(kEmbeddedLessEqual);
+    const string kEqual(kEmbeddedEqual);
+    const string kNotEqual(kEmbeddedNotEqual);
+    const string kGreaterThan(kEmbeddedGreaterThan);
+    const string kGreaterEqual(kEmbeddedGreaterEqual);
     const string kBranch[] = {kLessThan, kLessEqual, kEqual, kNotEqual, kGreaterThan, kGreaterEqual};
     const int kBranchSize = 6;
+    static_assert(sizeof(kEmbeddedBranch) / sizeof(kEmbeddedBranch[0]) == kBranchSize, "Wrong number of branches.");
 
     // Jump instruction.
-    const string kJump = "JUMP";
+    constexpr string_view kEmbeddedJump = "JUMP";
+    const string kJump(kEmbeddedJump);
 
     // Call instruction.
-    const string kCall = "CALL";
+    constexpr string_view kEmbeddedCall = "CALL";
+    const string kCall(kEmbeddedCall);
 
     // Return instruction.
-    const string kReturn = "RET";
+    constexpr string_view kEmbeddedReturn = "RET";
+    const string kReturn(kEmbeddedReturn);
 
     // Delimiters for the tokenizer.
-    const string kAllDelims = "+-*/=, ";
-    const string kIgnoreDelims = ", ";
+    constexpr string_view kEmbeddedAllDelims = "+-*/=, ";
+    constexpr string_view kEmbeddedIgnoreDelims = ", ";
+    const string kAllDelims(kEmbeddedAllDelims);
+    const string kIgnoreDelims(kEmbeddedIgnoreDelims);
 
 // For ALEMemory:
     // Initial value of the register 'SP'.
     const int kSPInitValue = INT_MAX - 3;
 
+// For ALEBatch:
+    // Statuses of a single lane.
+    const int kLaneRunning = 0;
+    const int kLaneReturned = 1; // Reached the final RET instruction.
+    const int kLaneHalted = 2; // Went past the last instruction.
+    const int kLaneFailed = 3;
+
+// For ALEEmbedded:
+    // Register slots: 'SP', 'RV', 'PC' and then 'R0', 'R1'... 'R31'.
+    const int kEmbeddedSPSlot = 0;
+    const int kEmbeddedRVSlot = 1;
+    const int kEmbeddedPCSlot = 2;
+    const int kEmbeddedFirstRegSlot = 3;
+    const int kEmbeddedRegCount = 32;
+    const int kEmbeddedSlotCount = kEmbeddedFirstRegSlot + kEmbeddedRegCount;
+
+    // Maximum number of components in a single instruction.
+    const int kEmbeddedMaxTokens = 8;
+
+    // Kinds of compiled instructions.
+    const int kEmbeddedNopInstr = 0;
+    const int kEmbeddedEvaluateInstr = 1; // E.g. 'R1' or 'R1 + 4', only checks registers.
+    const int kEmbeddedAssignInstr = 2;
+    const int kEmbeddedStoreInstr = 3;
+    const int kEmbeddedLoadInstr = 4;
+    const int kEmbeddedBranchInstr = 5;
+    const int kEmbeddedJumpInstr = 6;
+    const int kEmbeddedCallInstr = 7;
+    const int kEmbeddedReturnInstr = 8;
+
+    // Kinds of compiled branch instructions, their indices in kEmbeddedBranch array.
+    const int kEmbeddedLessThanBranch = 0;
+    const int kEmbeddedLessEqualBranch = 1;
+    const int kEmbeddedEqualBranch = 2;
+    const int kEmbeddedNotEqualBranch = 3;
+    const int kEmbeddedGreaterThanBranch = 4;
+    const int kEmbeddedGreaterEqualBranch = 5;
+    static_assert(kEmbeddedBranch[kEmbeddedLessThanBranch] == kEmbeddedLessThan
+                  && kEmbeddedBranch[kEmbeddedLessEqualBranch] == kEmbeddedLessEqual
+                  && kEmbeddedBranch[kEmbeddedEqualBranch] == kEmbeddedEqual
+                  && kEmbeddedBranch[kEmbeddedNotEqualBranch] == kEmbeddedNotEqual
+                  && kEmbeddedBranch[kEmbeddedGreaterThanBranch] == kEmbeddedGreaterThan
+                  && kEmbeddedBranch[kEmbeddedGreaterEqualBranch] == kEmbeddedGreaterEqual, "Wrong order of branches.");
+
 #endif
@@ -64,7 +64,7 @@ void ALEDatabase::PrintLine(int index) {
 
 int ALEDatabase::GetFunctionIndex(string function_name) {
     if (declared_functions.find(function_name) != declared_functions.end()) {
-        return declared_functions[function_name];
+        return declared_functions.at(function_name); // Read-only, programs may share the database.
     } else {
         string err_msg = "> Function \"" + function_name + "\" doesn't exist.";
         throw err_msg;
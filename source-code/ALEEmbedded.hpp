@@ -0,0 +1,661 @@
+// File: ALEEmbedded.hpp
+// Compile-time parsing and execution of embedded programs for Assembly Language Emulator.
+//
+// Program source is given as a string literal at namespace scope and is compiled
+// while the host C++ code is compiled, so compilation errors of the program become
+// build errors. Every instruction gets it's own function with all the operands
+// known at compile time. Only registers 'SP', 'RV', 'PC' and 'R0'...'R31' are
+// supported. E.g:
+//
+//     constexpr char kKernel[] = "R1 = 20\n RV = R1 + -10\n RET";
+//     constexpr auto kProgram = CompileEmbeddedProgram<CountEmbeddedLines(kKernel)>(kKernel);
+//
+//     ALEEmbeddedState state;
+//     int ret_value = RunEmbeddedProgram<kProgram>(&state);
+
+#ifndef ALEEmbedded_Interface
+#define ALEEmbedded_Interface
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <utility>
+#include "ALEConstants.hpp"
+#include "ALEMemory.h"
+
+using namespace std;
+
+// A number or a register slot.
+struct ALEEmbeddedOperand {
+    bool is_const = true;
+    int value = 0; // Number itself or a register slot.
+};
+
+// A single operand or an arithmetic operation(E.g. 'R1', '8' or 'SP + 4').
+struct ALEEmbeddedExpr {
+    ALEEmbeddedOperand left;
+    char op = 0; // One of kALUOperators, or 0 if there is only the left operand.
+    ALEEmbeddedOperand right;
+};
+
+// Compiled instruction.
+struct ALEEmbeddedLine {
+    int kind = kEmbeddedNopInstr;
+    int dest = 0; // Register slot of assign and load instructions.
+    int byte_count = sizeof(int);
+    int branch = 0; // Index of the branch instruction in kEmbeddedBranch array.
+    int function_index = 0; // First instruction of the called function.
+    string_view function_name;
+    ALEEmbeddedOperand left; // Compared values of the branch instruction.
+    ALEEmbeddedOperand right;
+    ALEEmbeddedExpr address; // Insides of M[*].
+    ALEEmbeddedExpr value; // Assigned or stored value, jump or branch destination.
+};
+
+// Compiled program, 'kMaxLines' is just an upper bound of it's size.
+template <size_t kMaxLines>
+struct ALEEmbeddedProgram {
+    array<ALEEmbeddedLine, kMaxLines> lines{};
+    int line_count = 0;
+};
+
+// Components of a single line(E.g. 'R1', '=' or 'M[R2 + 3]').
+struct ALEEmbeddedTokens {
+    string_view tokens[kEmbeddedMaxTokens];
+    int size = 0;
+};
+
+// Checks if given character is a digit.
+constexpr bool IsEmbeddedDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Checks if index'th character is a minus of a negative number(E.g. '-10').
+constexpr bool IsEmbeddedMinus(string_view line, size_t index) {
+    return line[index] == kEmbeddedALUOperators[1]
+           && index + 1 < line.length() && IsEmbeddedDigit(line[index + 1]);
+}
+
+// Checks if index'th character is '+', '-', '*', '/' or '='.
+constexpr bool IsEmbeddedOperator(string_view line, size_t index) {
+    return kEmbeddedAllDelims.find(line[index]) != string_view::npos
+           && kEmbeddedIgnoreDelims.find(line[index]) == string_view::npos
+           && !IsEmbeddedMinus(line, index);
+}
+
+// Same as ALEDatabase::CheckForInstrConstraint.
+constexpr bool CheckEmbeddedInstrConstraint(string_view line) {
+    if (line.find(kEmbeddedMemAccessPrefix) != string_view::npos
+        && line.find(kEmbeddedMemAccessPrefix, line.find(kEmbeddedMemAccessPrefix) + 1) != string_view::npos) return false;
+
+    int num_ALUs = 0;
+    for (size_t i = 0; i < line.length(); i++) {
+        if (kEmbeddedALUOperators.find(line[i]) != string_view::npos && !IsEmbeddedMinus(line, i)) num_ALUs++;
+    }
+
+    if (num_ALUs > 1) return false;
+    else if (num_ALUs == 0) return true;
+
+    if (line.find(kEmbeddedMemAccessPrefix) != string_view::npos) {
+        size_t left_bracket_index = line.find(kEmbeddedMemAccessOpen);
+        size_t right_bracket_index = line.find(kEmbeddedMemAccessClose);
+
+        for (size_t i = 0; i < kEmbeddedALUOperators.length(); i++) {
+            if (left_bracket_index < line.find(kEmbeddedALUOperators[i])
+                && right_bracket_index > line.find(kEmbeddedALUOperators[i])) return true;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// Same as ALEDatabase::InvalidLine.
+constexpr bool InvalidEmbeddedLine(string_view line) {
+    return !CheckEmbeddedInstrConstraint(line) || (line.length() > 0 && IsEmbeddedDigit(line[0]));
+}
+
+// Same as ALEDatabase::RemoveComment.
+constexpr string_view RemoveEmbeddedComment(string_view line) {
+    return line.substr(0, line.find(kEmbeddedCommentPrefix));
+}
+
+// Splits given line into the same components as ALEDatabase::ParseLine.
+constexpr ALEEmbeddedTokens ParseEmbeddedLine(string_view line) {
+    ALEEmbeddedTokens line_data;
+
+    size_t i = 0;
+    while (i < line.length()) {
+        if (kEmbeddedIgnoreDelims.find(line[i]) != string_view::npos) {
+            i++;
+            continue;
+        }
+
+        size_t end = i + 1;
+        if (line.substr(i, kEmbeddedMemAccessPrefix.length()) == kEmbeddedMemAccessPrefix) {
+            end = line.find(kEmbeddedMemAccessClose, i);
+            if (end == string_view::npos) throw string("> Compilation error at: \"" + string(line) + "\".");
+            end++;
+        } else if (!IsEmbeddedOperator(line, i)) {
+            while (end < line.length()
+                   && kEmbeddedIgnoreDelims.find(line[end]) == string_view::npos
+                   && !IsEmbeddedOperator(line, end)) end++;
+        }
+
+        if (line_data.size == kEmbeddedMaxTokens) throw string("> Compilation error at: \"" + string(line) + "\".");
+        line_data.tokens[line_data.size++] = line.substr(i, end - i);
+        i = end;
+    }
+
+    return line_data;
+}
+
+// Checks if given component is a number(E.g. '99' or '-10').
+constexpr bool IsEmbeddedNumber(string_view component) {
+    return IsEmbeddedDigit(component[0])
+           || (component[0] == kEmbeddedALUOperators[1] && component.length() > 1 && IsEmbeddedDigit(component[1]));
+}
+
+// Converts given number the same way as 'stoi' does.
+constexpr int ParseEmbeddedNumber(string_view component) {
+    bool negative = component[0] == kEmbeddedALUOperators[1];
+    long long value = 0;
+
+    for (size_t i = negative ? 1 : 0; i < component.length() && IsEmbeddedDigit(component[i]); i++) {
+        value = value * 10 + (component[i] - '0');
+        if (value > (long long)INT_MAX + 1) throw string("> Number \"" + string(component) + "\" is out of range.");
+    }
+
+    if (negative) value = -value;
+    if (value > INT_MAX) throw string("> Number \"" + string(component) + "\" is out of range.");
+
+    return (int)value;
+}
+
+// Returns register slot of given register(E.g. 'SP' or 'R3').
+constexpr int GetEmbeddedRegSlot(string_view reg) {
+    if (reg == kEmbeddedStackPointer) return kEmbeddedSPSlot;
+    if (reg == kEmbeddedRetValue) return kEmbeddedRVSlot;
+    if (reg == kEmbeddedCurrInstrPointer) return kEmbeddedPCSlot;
+
+    if (reg.length() > 1 && reg.length() <= 3 && reg.substr(0, 1) == kEmbeddedRegisterPrefix) {
+        int number = 0;
+        for (size_t i = 1; i < reg.length(); i++) {
+            if (!IsEmbeddedDigit(reg[i])) throw string("> Unsupported register \"" + string(reg) + "\".");
+            number = number * 10 + (reg[i] - '0');
+        }
+
+        if (number < kEmbeddedRegCount) return kEmbeddedFirstRegSlot + number;
+    }
+
+    throw string("> Unsupported register \"" + string(reg) + "\".");
+}
+
+// Returns name of the register in given slot.
+inline string GetEmbeddedRegName(int slot) {
+    if (slot == kEmbeddedSPSlot) return kStackPointer;
+    if (slot == kEmbeddedRVSlot) return kRetValue;
+    if (slot == kEmbeddedPCSlot) return kCurrInstrPointer;
+
+    return kRegisterPrefix + to_string(slot - kEmbeddedFirstRegSlot);
+}
+
+// Compiles a number or a register.
+constexpr ALEEmbeddedOperand CompileEmbeddedOperand(string_view component) {
+    ALEEmbeddedOperand operand;
+
+    if (IsEmbeddedNumber(component)) {
+        operand.value = ParseEmbeddedNumber(component);
+    } else {
+        operand.is_const = false;
+        operand.value = GetEmbeddedRegSlot(component);
+    }
+
+    return operand;
+}
+
+// Compiles 'size' components starting from the 'first' one(E.g. 'R1' or 'PC + 32').
+constexpr ALEEmbeddedExpr CompileEmbeddedExpr(const ALEEmbeddedTokens &line_data, int first, int size) {
+    ALEEmbeddedExpr expr;
+
+    if (size == 1) {
+        expr.left = CompileEmbeddedOperand(line_data.tokens[first]);
+    } else if (size == 3 && line_data.tokens[first + 1] != "=") {
+        expr.left = CompileEmbeddedOperand(line_data.tokens[first]);
+        expr.right = CompileEmbeddedOperand(line_data.tokens[first + 2]);
+
+        // Same as ALU of the emulator: everything except '+', '-' and '*' divides.
+        char op = line_data.tokens[first + 1][0];
+        if (op == kEmbeddedALUOperators[0] || op == kEmbeddedALUOperators[1] || op == kEmbeddedALUOperators[2]) expr.op = op;
+        else expr.op = kEmbeddedALUOperators[3];
+    } else {
+        throw string("> Invalid expression in embedded program.");
+    }
+
+    return expr;
+}
+
+// Compiles insides of M[*].
+constexpr ALEEmbeddedExpr CompileEmbeddedContent(string_view component) {
+    size_t open = component.find(kEmbeddedMemAccessOpen);
+    string_view content = component.substr(open + 1, component.find(kEmbeddedMemAccessClose) - open - 1);
+
+    ALEEmbeddedTokens content_data = ParseEmbeddedLine(content);
+    return CompileEmbeddedExpr(content_data, 0, content_data.size);
+}
+
+// Returns byte count of '=.1' or '=.2' modifier.
+constexpr int CompileEmbeddedByteCount(string_view component) {
+    if (component.length() != 2 || component[1] < '1' || component[1] > '4') {
+        throw string("> Invalid byte count \"" + string(component) + "\".");
+    }
+
+    return component[1] - '0';
+}
+
+// Compiles instructions which are evaluated by Evaluate of the emulator.
+constexpr ALEEmbeddedLine CompileEmbeddedEvaluate(const ALEEmbeddedTokens &line_data) {
+    ALEEmbeddedLine line;
+    const string_view* tokens = line_data.tokens;
+
+    // If we have only a number or a register.
+    if (line_data.size == 1) {
+        line.kind = kEmbeddedEvaluateInstr;
+        line.value = CompileEmbeddedExpr(line_data, 0, 1);
+    }
+    // If current line contains only one operator(E.g. '+', '-', '*' or '/').
+    else if (line_data.size == 3 && tokens[1] != "=") {
+        line.kind = kEmbeddedEvaluateInstr;
+        line.value = CompileEmbeddedExpr(line_data, 0, 3);
+    }
+    // If current line contains more than one operator(E.g. '=' and '+', '-', '*' or '/').
+    else if (line_data.size == 5) {
+        line.kind = kEmbeddedAssignInstr;
+        line.dest = GetEmbeddedRegSlot(tokens[0]);
+        line.value = CompileEmbeddedExpr(line_data, 2, 3);
+    }
+    // Store(E.g. 'M[R1] = R2', 'M[R1 + 10] = 9', 'M[R1] =.2 R2'...).
+    else if (tokens[0].find(kEmbeddedMemAccessPrefix) != string_view::npos && (line_data.size == 3 || line_data.size == 4)) {
+        line.kind = kEmbeddedStoreInstr;
+        line.address = CompileEmbeddedContent(tokens[0]);
+        if (line_data.size == 4) line.byte_count = CompileEmbeddedByteCount(tokens[2]);
+        line.value = CompileEmbeddedExpr(line_data, line_data.size - 1, 1);
+    }
+    // Load(E.g. 'R1 = M[R2]', 'R1 =.1 M[R2]'...).
+    else if ((line_data.size == 3 || line_data.size == 4)
+             && tokens[line_data.size - 1].find(kEmbeddedMemAccessPrefix) != string_view::npos)
+    {
+        line.kind = kEmbeddedLoadInstr;
+        line.dest = GetEmbeddedRegSlot(tokens[0]);
+        line.address = CompileEmbeddedContent(tokens[line_data.size - 1]);
+        if (line_data.size == 4) line.byte_count = CompileEmbeddedByteCount(tokens[2]);
+    }
+    // E.g 'R1 = R2', 'R1 = 64' or 'R1 =.1 R2'.
+    else if (line_data.size == 3 || line_data.size == 4) {
+        line.kind = kEmbeddedAssignInstr;
+        line.dest = GetEmbeddedRegSlot(tokens[0]);
+        line.value = CompileEmbeddedExpr(line_data, line_data.size - 1, 1);
+    } else {
+        throw string("> Invalid instruction in embedded program.");
+    }
+
+    return line;
+}
+
+// Compiles a single instruction the same way RunProgram recognizes it.
+constexpr ALEEmbeddedLine CompileEmbeddedLine(const ALEEmbeddedTokens &line_data) {
+    ALEEmbeddedLine line;
+    string_view identifier = line_data.tokens[0];
+
+    if (identifier == kEmbeddedReturn) {
+        line.kind = kEmbeddedReturnInstr;
+    } else if (identifier == kEmbeddedStackPointer
+               || identifier == kEmbeddedRetValue
+               || identifier.find(kEmbeddedRegisterPrefix) != string_view::npos
+               || identifier.find(kEmbeddedMemAccessPrefix) != string_view::npos)
+    {
+        line = CompileEmbeddedEvaluate(line_data);
+    } else if (identifier == kEmbeddedCall) {
+        if (line_data.size != 2) throw string("> Invalid call instruction in embedded program.");
+
+        line.kind = kEmbeddedCallInstr;
+        line.function_name = line_data.tokens[1];
+    } else if (identifier == kEmbeddedJump) {
+        line.kind = kEmbeddedJumpInstr;
+        line.value = CompileEmbeddedExpr(line_data, 1, line_data.size - 1);
+    } else {
+        for (int i = 0; i < kBranchSize; i++) {
+            if (identifier != kEmbeddedBranch[i]) continue;
+            if (line_data.size < 4) throw string("> Invalid branch instruction in embedded program.");
+
+            line.kind = kEmbeddedBranchInstr;
+            line.branch = i;
+            line.left = CompileEmbeddedOperand(line_data.tokens[1]);
+            line.right = CompileEmbeddedOperand(line_data.tokens[2]);
+            line.value = CompileEmbeddedExpr(line_data, 3, line_data.size - 3);
+        }
+    }
+
+    return line;
+}
+
+// Returns an upper bound of the number of instructions in given source.
+constexpr size_t CountEmbeddedLines(string_view source) {
+    size_t count = 1;
+    for (size_t i = 0; i < source.length(); i++) {
+        if (source[i] == '\n') count++;
+    }
+
+    return count;
+}
+
+// Compiles given source, same as ALEDatabase does on load. Must be used in a
+// constant expression, so any compilation error stops the build.
+template <size_t kMaxLines>
+constexpr ALEEmbeddedProgram<kMaxLines> CompileEmbeddedProgram(string_view source) {
+    ALEEmbeddedProgram<kMaxLines> program;
+    array<string_view, kMaxLines> function_names{};
+    array<int, kMaxLines> function_indices{};
+    size_t function_count = 0;
+
+    size_t line_start = 0;
+    while (line_start <= source.length()) {
+        size_t line_end = source.find('\n', line_start);
+        if (line_end == string_view::npos) line_end = source.length();
+
+        string_view line = source.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+
+        if (InvalidEmbeddedLine(line)) throw string("> Compilation error at: \"" + string(line) + "\".");
+
+        ALEEmbeddedTokens line_data = ParseEmbeddedLine(RemoveEmbeddedComment(line));
+        if (line_data.size == 0) continue;
+
+        string_view identifier = line_data.tokens[0];
+        if (identifier.find(kEmbeddedFuncDeclOpen) != string_view::npos
+            && identifier.find(kEmbeddedFuncDeclClose) != string_view::npos)
+        {
+            for (size_t i = 0; i < function_count; i++) {
+                if (function_names[i] == identifier) {
+                    throw string("> Redeclaration of function \"" + string(identifier) + "\".");
+                }
+            }
+
+            function_names[function_count] = identifier;
+            function_indices[function_count] = program.line_count;
+            function_count++;
+            continue;
+        }
+
+        program.lines[program.line_count++] = CompileEmbeddedLine(line_data);
+    }
+
+    // Functions may be declared after they are called, so calls are resolved last.
+    for (int i = 0; i < program.line_count; i++) {
+        if (program.lines[i].kind != kEmbeddedCallInstr) continue;
+
+        size_t function = 0;
+        while (function < function_count && function_names[function] != program.lines[i].function_name) function++;
+
+        if (function == function_count) {
+            throw string("> Function \"" + string(program.lines[i].function_name) + "\" doesn't exist.");
+        }
+
+        program.lines[i].function_index = function_indices[function];
+    }
+
+    return program;
+}
+
+class ALEEmbeddedState {
+    public:
+        // Initializes registers and address space of an embedded program.
+        ALEEmbeddedState();
+
+        // Destructor isn't needed.
+        ~ALEEmbeddedState();
+
+        // Assigns given value to the register in given slot.
+        void PutRegValue(int slot, int value);
+
+        // Assigns given value to given register(E.g. 'R1'), used to pass arguments.
+        void PutRegValue(string reg, int value);
+
+        // Returns a value from the register in given slot if it's initialized.
+        int GetRegValue(int slot);
+
+        // Returns address space of the program.
+        ALEMemory* GetMemory();
+
+        // If we have call instruction this code is performed.
+        void CallInstr(int saved_index);
+
+        // If we have return instruction this code is performed. Returns index of
+        // the next instruction, or 'end_index' on the final RET.
+        int ReturnInstr(int end_index);
+
+        // Checks if the program reached the final RET instruction.
+        bool HasReturned();
+
+        // Returns value of 'RV' at the final RET instruction.
+        int GetRetValue();
+    private:
+        int register_data[kEmbeddedSlotCount]; // Registers indexed by their slots.
+        bool initialized[kEmbeddedSlotCount]; // Initialized registers.
+        ALEMemory prog_memory; // Emulation of stack memory.
+        int num_of_calls; // Current call depth.
+        bool returned;
+        int ret_value;
+};
+
+inline ALEEmbeddedState::ALEEmbeddedState() {
+    for (int i = 0; i < kEmbeddedSlotCount; i++) {
+        register_data[i] = 0;
+        initialized[i] = false;
+    }
+
+    PutRegValue(kEmbeddedSPSlot, kSPInitValue);
+    num_of_calls = 0;
+    returned = false;
+    ret_value = 0;
+}
+
+inline ALEEmbeddedState::~ALEEmbeddedState() {
+    // Destructor isn't needed.
+}
+
+inline void ALEEmbeddedState::PutRegValue(int slot, int value) {
+    register_data[slot] = value;
+    initialized[slot] = true;
+}
+
+inline void ALEEmbeddedState::PutRegValue(string reg, int value) {
+    PutRegValue(GetEmbeddedRegSlot(reg), value);
+}
+
+inline int ALEEmbeddedState::GetRegValue(int slot) {
+    if (initialized[slot]) {
+        return register_data[slot];
+    } else {
+        string err_msg = "> Register \"" + GetEmbeddedRegName(slot) + "\" doesn't exist.";
+        throw err_msg;
+    }
+}
+
+inline ALEMemory* ALEEmbeddedState::GetMemory() {
+    return &prog_memory;
+}
+
+inline void ALEEmbeddedState::CallInstr(int saved_index) {
+    int curr_stack_pointer = register_data[kEmbeddedSPSlot] - 4;
+    register_data[kEmbeddedSPSlot] = curr_stack_pointer;
+    prog_memory.WriteAddr(saved_index * 4, curr_stack_pointer, sizeof(int));
+
+    num_of_calls++;
+}
+
+inline int ALEEmbeddedState::ReturnInstr(int end_index) {
+    if (num_of_calls != 0) {
+        int curr_stack_pointer = register_data[kEmbeddedSPSlot];
+        int index = prog_memory.ReadAddr(curr_stack_pointer, sizeof(int)) / 4;
+        register_data[kEmbeddedSPSlot] = curr_stack_pointer + 4;
+
+        num_of_calls--;
+        return index;
+    }
+
+    if (register_data[kEmbeddedSPSlot] != kSPInitValue) {
+        string err_msg = "> Memory leak detected.";
+        throw err_msg;
+    }
+
+    ret_value = GetRegValue(kEmbeddedRVSlot);
+    returned = true;
+    return end_index;
+}
+
+inline bool ALEEmbeddedState::HasReturned() {
+    return returned;
+}
+
+inline int ALEEmbeddedState::GetRetValue() {
+    return ret_value;
+}
+
+// Returns the value of given number or register.
+template <bool is_const, int value>
+int EvaluateEmbeddedOperand(ALEEmbeddedState* state) {
+    if constexpr (is_const) return value;
+    else return state->GetRegValue(value);
+}
+
+// Returns the value of given field of index'th instruction(E.g. 'R1' or 'SP + 4').
+template <const auto &program, int index, ALEEmbeddedExpr ALEEmbeddedLine::*field>
+int EvaluateEmbeddedExpr(ALEEmbeddedState* state) {
+    constexpr ALEEmbeddedExpr expr = program.lines[index].*field;
+    int left = EvaluateEmbeddedOperand<expr.left.is_const, expr.left.value>(state);
+
+    if constexpr (expr.op == 0) {
+        return left;
+    } else {
+        int right = EvaluateEmbeddedOperand<expr.right.is_const, expr.right.value>(state);
+
+        if constexpr (expr.op == kEmbeddedALUOperators[0]) return left + right;
+        else if constexpr (expr.op == kEmbeddedALUOperators[1]) return left - right;
+        else if constexpr (expr.op == kEmbeddedALUOperators[2]) return left * right;
+        else return left / right;
+    }
+}
+
+// Checks if given jump destination is known at compile time(E.g. 'PC + 32' or '16').
+constexpr bool IsEmbeddedStaticTarget(const ALEEmbeddedExpr &expr, int index) {
+    long long dest = 0;
+    if (expr.op == 0 && expr.left.is_const) dest = expr.left.value;
+    else if (expr.op == kEmbeddedALUOperators[0] && !expr.left.is_const && expr.left.value == kEmbeddedPCSlot
+             && expr.right.is_const) dest = index * 4LL + expr.right.value;
+    else if (expr.op == kEmbeddedALUOperators[1] && !expr.left.is_const && expr.left.value == kEmbeddedPCSlot
+             && expr.right.is_const) dest = index * 4LL - expr.right.value;
+    else return false;
+
+    return dest >= INT_MIN && dest <= INT_MAX;
+}
+
+// Returns index of the instruction at given jump destination known at compile time.
+constexpr int GetEmbeddedStaticTarget(const ALEEmbeddedExpr &expr, int index) {
+    if (expr.op == 0) return expr.left.value / 4;
+    if (expr.op == kEmbeddedALUOperators[0]) return (index * 4 + expr.right.value) / 4;
+    return (index * 4 - expr.right.value) / 4;
+}
+
+template <const auto &program, int index>
+int ExecuteEmbeddedLine(ALEEmbeddedState* state);
+
+// Moves from index'th instruction to the next one known at compile time. If it's
+// further in the program it's executed directly so the compiler can inline it.
+// Otherwise it's index is returned to RunEmbeddedLines, so loops don't grow the stack.
+template <const auto &program, int index, int next>
+int ContinueEmbeddedLine(ALEEmbeddedState* state) {
+    if constexpr (next > index && next < program.line_count) return ExecuteEmbeddedLine<program, next>(state);
+    else return next;
+}
+
+// Executes index'th instruction and returns index of the next one.
+template <const auto &program, int index>
+int ExecuteEmbeddedLine(ALEEmbeddedState* state) {
+    constexpr ALEEmbeddedLine line = program.lines[index];
+    state->PutRegValue(kEmbeddedPCSlot, index * 4);
+
+    if constexpr (line.kind == kEmbeddedReturnInstr) {
+        return state->ReturnInstr(program.line_count);
+    } else if constexpr (line.kind == kEmbeddedEvaluateInstr) {
+        EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::value>(state);
+    } else if constexpr (line.kind == kEmbeddedAssignInstr) {
+        state->PutRegValue(line.dest, EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::value>(state));
+    } else if constexpr (line.kind == kEmbeddedStoreInstr) {
+        int address = EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::address>(state);
+        int value = EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::value>(state);
+        state->GetMemory()->WriteAddr(value, address, line.byte_count);
+    } else if constexpr (line.kind == kEmbeddedLoadInstr) {
+        int address = EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::address>(state);
+        state->PutRegValue(line.dest, state->GetMemory()->ReadAddr(address, line.byte_count));
+    } else if constexpr (line.kind == kEmbeddedCallInstr) {
+        state->CallInstr(index + 1);
+        return ContinueEmbeddedLine<program, index, line.function_index>(state);
+    } else if constexpr (line.kind == kEmbeddedJumpInstr) {
+        if constexpr (IsEmbeddedStaticTarget(line.value, index)) {
+            return ContinueEmbeddedLine<program, index, GetEmbeddedStaticTarget(line.value, index)>(state);
+        } else {
+            return EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::value>(state) / 4;
+        }
+    } else if constexpr (line.kind == kEmbeddedBranchInstr) {
+        int left = EvaluateEmbeddedOperand<line.left.is_const, line.left.value>(state);
+        int right = EvaluateEmbeddedOperand<line.right.is_const, line.right.value>(state);
+
+        bool result;
+        if constexpr (line.branch == kEmbeddedLessThanBranch) result = left < right;
+        else if constexpr (line.branch == kEmbeddedLessEqualBranch) result = left <= right;
+        else if constexpr (line.branch == kEmbeddedEqualBranch) result = left == right;
+        else if constexpr (line.branch == kEmbeddedNotEqualBranch) result = left != right;
+        else if constexpr (line.branch == kEmbeddedGreaterThanBranch) result = left > right;
+        else result = left >= right;
+
+        if constexpr (IsEmbeddedStaticTarget(line.value, index)) {
+            if (result) return ContinueEmbeddedLine<program, index, GetEmbeddedStaticTarget(line.value, index)>(state);
+        } else {
+            int jump_dest = EvaluateEmbeddedExpr<program, index, &ALEEmbeddedLine::value>(state);
+            if (result) return jump_dest / 4;
+        }
+    }
+
+    return ContinueEmbeddedLine<program, index, index + 1>(state);
+}
+
+// Runs the program. Instructions reached by RET, by a computed jump or by jumping
+// backwards are started through a table of instruction functions.
+template <const auto &program, size_t... indices>
+int RunEmbeddedLines(ALEEmbeddedState* state, index_sequence<indices...>) {
+    if constexpr (sizeof...(indices) != 0) {
+        typedef int (*EmbeddedLineFunc)(ALEEmbeddedState*);
+        static constexpr EmbeddedLineFunc kLineFuncs[] = {&ExecuteEmbeddedLine<program, indices>...};
+
+        for (int i = 0; i >= 0 && i < program.line_count;) {
+            i = kLineFuncs[i](state);
+        }
+    }
+
+    if (!state->HasReturned()) {
+        string err_msg = "> Program ended without final RET instruction.";
+        throw err_msg;
+    }
+
+    return state->GetRetValue();
+}
+
+// Emulates given compiled program and returns the value of 'RV' at it's final RET.
+template <const auto &program>
+int RunEmbeddedProgram(ALEEmbeddedState* state) {
+    return RunEmbeddedLines<program>(state, make_index_sequence<program.line_count>());
+}
+
+#endif
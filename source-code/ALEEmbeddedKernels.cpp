@@ -0,0 +1,21 @@
+// File: ALEEmbeddedKernels.cpp
+// Embedded programs built into Assembly Language Emulator.
+
+#include "ALEEmbeddedKernels.h"
+
+// Program of 'test1.asm'.
+constexpr char kTest1Kernel[] =
+    "SP = SP - 4\n"
+    "R1 = 20\n"
+    "R2 = R1 + -10\n"
+    "RV = R2\n"
+    "SP = SP + 4\n"
+    "RET\n";
+
+constexpr auto kTest1Program = CompileEmbeddedProgram<CountEmbeddedLines(kTest1Kernel)>(kTest1Kernel);
+static_assert(kTest1Program.line_count == 6, "Wrong number of lines in test1 kernel.");
+static_assert(kTest1Program.lines[5].kind == kEmbeddedReturnInstr, "Test1 kernel must end with RET.");
+
+int RunTest1Kernel(ALEEmbeddedState* state) {
+    return RunEmbeddedProgram<kTest1Program>(state);
+}
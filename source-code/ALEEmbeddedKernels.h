@@ -0,0 +1,14 @@
+// File: ALEEmbeddedKernels.h
+// Embedded programs built into Assembly Language Emulator.
+
+#ifndef ALEEmbeddedKernels_Interface
+#define ALEEmbeddedKernels_Interface
+
+#include "ALEEmbedded.hpp"
+
+// Runs the program of 'test1.asm' compiled together with the emulator and
+// returns it's 'RV'(10). It's part of every build, so broken templates of
+// ALEEmbedded fail the build instead of waiting for a user of the header.
+int RunTest1Kernel(ALEEmbeddedState* state);
+
+#endif
@@ -0,0 +1,332 @@
+// File: ALEProcess.cpp
+// Resumable emulation of a single program for Assembly Language Emulator.
+
+#include <iostream>
+#include <stdexcept>
+#include "ALEProcess.h"
+#include "ALEConstants.hpp"
+
+// Checks if kBranch array contains string 'a'.
+bool Contains(string a);
+
+// If we have branch instruction this code is performed.
+int BranchInstr(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// If we have call instruction this code is performed.
+int CallInstr(vector<string> &line_data, int saved_index, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// If we have jump instruction this code is performed.
+int JumpInstr(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// Returns the value of given register or a number(E.g. 'R1', 'SP', '99'...),
+// or the value calculated from given arithmetic operation(E.g. 'R1 + -10'),
+// or from given instruction's right half of equation(E.g. 'R1 = R2 + 9') and also
+// stores that value to the left register.
+// Also performs store/load instruction if necessary(E.g. 'M[R1] = 1', 'R2 = M[SP]'...).
+int Evaluate(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// Executes store instruction(E.g. 'M[R1] = R2', 'M[R1 + 10] = 9', 'M[R1] =.2 R2'...).
+int StoreInstr(string dest, string source, int byte_count, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// Executes load instruction(E.g. 'R1 = M[R2]', 'R1 =.2 M[R2 + 9]'...).
+int LoadInstr(string dest, string source, int byte_count, ALEDatabase* prog_data, ALEMemory* prog_memory);
+
+// Extracts insides of M[*].
+vector<string> GetContent(string component, ALEDatabase* prog_data);
+
+// Evaluates specified arithmetic instruction.
+int ALU(string left, string op, string right, ALEMemory* prog_memory);
+
+ALEProcess::ALEProcess(ALEDatabase* prog_data, ALEMemory* prog_memory, bool print_mode) {
+    this->prog_data = prog_data;
+    this->prog_memory = prog_memory;
+    this->print_mode = print_mode;
+    index = 0;
+    num_of_calls = 0;
+    finished = false;
+    returned = false;
+    ret_value = 0;
+}
+
+ALEProcess::~ALEProcess() {
+    // Destructor isn't needed.
+}
+
+bool ALEProcess::Run(int quantum) {
+    for (int i = 0; i < quantum && !finished; i++) {
+        if (index < 0 || index >= prog_data->GetLineCount()) {
+            finished = true;
+            break;
+        }
+
+        // 'stoi' throws if a number doesn't fit in an int(E.g. 'R1 = 99999999999').
+        try {
+            Step();
+        } catch (out_of_range &err) {
+            string err_msg = "> Number is out of range.";
+            throw err_msg;
+        }
+    }
+
+    return finished;
+}
+
+void ALEProcess::Abort(string err_msg) {
+    this->err_msg = err_msg;
+    finished = true;
+}
+
+bool ALEProcess::HasFinished() {
+    return finished;
+}
+
+bool ALEProcess::HasReturned() {
+    return returned;
+}
+
+int ALEProcess::GetRetValue() {
+    return ret_value;
+}
+
+string ALEProcess::GetErrorMessage() {
+    return err_msg;
+}
+
+void ALEProcess::Step() {
+    prog_memory->PutRegValue(kCurrInstrPointer, index * 4);
+
+    if (print_mode) prog_data->PrintLine(index);
+
+    vector<string> line_data = prog_data->GetLineAt(index);
+    string identifier = line_data[0];
+
+    if (identifier == kReturn) {
+        if (num_of_calls != 0) {
+            int curr_stack_pointer = prog_memory->GetRegValue(kStackPointer);
+            index = prog_memory->ReadAddr(curr_stack_pointer, sizeof(int)) / 4;
+            curr_stack_pointer += 4;
+            prog_memory->PutRegValue(kStackPointer, curr_stack_pointer);
+
+            num_of_calls--;
+            return;
+        } else {
+            if (prog_memory->GetRegValue(kStackPointer) != kSPInitValue) {
+                string err_msg = "> Memory leak detected.";
+                throw err_msg;
+            }
+
+            ret_value = prog_memory->GetRegValue(kRetValue);
+            returned = true;
+            finished = true;
+            return;
+        }
+    } else if (identifier == kStackPointer 
+               || identifier == kRetValue
+               || identifier.find(kRegisterPrefix) != -1
+               || identifier.find(kMemAccessPrefix) != -1)
+    {
+        Evaluate(line_data, prog_data, prog_memory);
+    } else if (identifier == kCall) {
+        num_of_calls++;
+        index = CallInstr(line_data, index + 1, prog_data, prog_memory);
+        return;
+    } else if (identifier == kJump) {
+        index = JumpInstr(line_data, prog_data, prog_memory);
+        return;
+    } else if (Contains(identifier)) {
+        index = BranchInstr(line_data, prog_data, prog_memory);
+        return;
+    }
+    
+    index++;
+}
+
+bool Contains(string a) {
+    for (int i = 0; i < kBranchSize; i++) {
+        if (a == kBranch[i]) return true;
+    }
+
+    return false;
+}
+
+int BranchInstr(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    vector<string> first_segment(line_data.begin() + 1, line_data.begin() + 2);
+    vector<string> second_segment(line_data.begin() + 2, line_data.begin() + 3);
+    vector<string> third_segment(line_data.begin() + 3, line_data.end());
+
+    string op = line_data[0];
+    int left = Evaluate(first_segment, prog_data, prog_memory);
+    int right = Evaluate(second_segment, prog_data, prog_memory);
+    int jump_dest = Evaluate(third_segment, prog_data, prog_memory);
+    
+    bool result = false;
+    
+    if (op == kLessThan) {
+        result = left < right;
+    } else if (op == kLessEqual) {
+        result = left <= right;
+    } else if (op == kEqual) {
+        result = left == right;
+    } else if (op == kNotEqual) {
+        result = left != right;
+    } else if (op == kGreaterThan) {
+        result = left > right;
+    } else if (op == kGreaterEqual) {
+        result = left >= right;
+    }
+    
+    if (result) return jump_dest / 4;
+    else return prog_memory->GetRegValue(kCurrInstrPointer) / 4 + 1;
+}
+
+int CallInstr(vector<string> &line_data, int saved_index, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    int curr_stack_pointer = prog_memory->GetRegValue(kStackPointer);
+    curr_stack_pointer -= 4;
+    prog_memory->PutRegValue(kStackPointer, curr_stack_pointer);
+    prog_memory->WriteAddr(saved_index * 4, curr_stack_pointer, sizeof(int));
+
+    int function_index = prog_data->GetFunctionIndex(line_data[1]);
+    return function_index;
+}
+
+int JumpInstr(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    line_data.erase(line_data.begin());
+    return Evaluate(line_data, prog_data, prog_memory) / 4;
+}
+
+int Evaluate(vector<string> &line_data, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    // If we have only a number or a register.
+    if (line_data.size() == 1) {
+        if (isdigit(line_data[0][0]) || (line_data[0][0] == kALUOperators[1] && isdigit(line_data[0][1]))) {
+            return stoi(line_data[0]);
+        } else {
+            return prog_memory->GetRegValue(line_data[0]);
+        }
+    }
+    // If current line contains only one operator(E.g. '+', '-', '*' or '/').
+    else if (line_data.size() == 3 && line_data[1] != "=") {
+        string left = line_data[0];
+        string op = line_data[1];
+        string right = line_data[2];
+
+        return ALU(left, op, right, prog_memory);
+    }
+    // If current line contains more than one operator(E.g. '=' and '+', '-', '*' or '/').
+    else if (line_data.size() == 5) {
+        string left = line_data[2];
+        string op = line_data[3];
+        string right = line_data[4];
+        int value = ALU(left, op, right, prog_memory);
+        prog_memory->PutRegValue(line_data[0], value);
+        return value;
+    }
+    // If current line contains only one operator('=') or additional ".1" (1 byte) or ".2" (2 bytes).
+    else {
+        // Store(E.g. 'M[R1] = R2', 'M[R1 + 10] = 9', 'M[R1] =.2 R2'...).
+        if (line_data[0].find(kMemAccessPrefix) != -1) {
+            if (line_data.size() == 3) {
+                return StoreInstr(line_data[0], line_data[2], sizeof(int), prog_data, prog_memory);
+            } else {
+                int byte_count = line_data[2][1] - '0';
+                return StoreInstr(line_data[0], line_data[3], byte_count, prog_data, prog_memory);
+            }
+        }
+        // Load(E.g. 'R1 = M[R2]'...).
+        else if (line_data.size() == 3 && line_data[2].find(kMemAccessPrefix) != -1) {
+            return LoadInstr(line_data[0], line_data[2], sizeof(int), prog_data, prog_memory);
+        }
+        // Load(E.g. 'R1 =.1 M[R2]'...).
+        else if (line_data.size() == 4 && line_data[3].find(kMemAccessPrefix) != -1) {
+            int byte_count = line_data[2][1] - '0';
+            return LoadInstr(line_data[0], line_data[3], byte_count, prog_data, prog_memory);
+        }
+        // E.g 'R1 =.1 R2' or 'R1 =.2 64'.
+        else if (line_data.size() == 4) {
+            int value;
+            if (isdigit(line_data[3][0]) || (line_data[3][0] == kALUOperators[1] && isdigit(line_data[3][1]))) {
+                value = stoi(line_data[3]);
+            } else {
+                value = prog_memory->GetRegValue(line_data[3]);
+            }
+
+            prog_memory->PutRegValue(line_data[0], value);
+
+            return value;
+        }
+        // E.g 'R1 = R2' or 'R1 = 64'.
+        else if (isdigit(line_data[2][0]) || (line_data[2][0] == kALUOperators[1] && isdigit(line_data[2][1]))) {
+            int value = stoi(line_data[2]);
+            prog_memory->PutRegValue(line_data[0], value);
+
+            return value;
+        } else {
+            int value = prog_memory->GetRegValue(line_data[2]);
+            prog_memory->PutRegValue(line_data[0], value);
+
+            return value;
+        }
+    }
+}
+
+int StoreInstr(string dest, string source, int byte_count, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    vector<string> content_data = GetContent(dest, prog_data);
+    int content_value = Evaluate(content_data, prog_data, prog_memory);
+
+    int value;
+    if (isdigit(source[0]) || (source[0] == kALUOperators[1] && isdigit(source[1]))) value = stoi(source);
+    else value = prog_memory->GetRegValue(source);
+
+    prog_memory->WriteAddr(value, content_value, byte_count);
+
+    return value;
+}
+
+int LoadInstr(string dest, string source, int byte_count, ALEDatabase* prog_data, ALEMemory* prog_memory) {
+    vector<string> content_data = GetContent(source, prog_data);
+    int content_value = Evaluate(content_data, prog_data, prog_memory);
+
+    int value = prog_memory->ReadAddr(content_value, byte_count);
+    prog_memory->PutRegValue(dest, value);
+
+    return value;
+}
+
+vector<string> GetContent(string component, ALEDatabase* prog_data) {
+    string content = component.substr(2, component.find(kMemAccessClose) - component.find(kMemAccessOpen) - 1);
+
+    return prog_data->ParseLine(content);
+}
+
+int ALU(string left, string op, string right, ALEMemory* prog_memory) {
+    int left_value;
+    int right_value;
+    
+    if ((isdigit(left[0]) || (left[0] == kALUOperators[1] && isdigit(left[1]))) 
+        && (isdigit(right[0]) || (right[0] == kALUOperators[1] && isdigit(right[1])))) {
+        left_value = stoi(left);
+        right_value = stoi(right);
+    } else if (isdigit(left[0]) || (left[0] == kALUOperators[1] && isdigit(left[1]))) {
+        left_value = stoi(left);
+        right_value = prog_memory->GetRegValue(right);
+    } else if (isdigit(right[0]) || (right[0] == kALUOperators[1] && isdigit(right[1]))) {
+        left_value = prog_memory->GetRegValue(left);
+        right_value = stoi(right);
+    } else {
+        left_value = prog_memory->GetRegValue(left);
+        right_value = prog_memory->GetRegValue(right);
+    }
+
+    if (op[0] == kALUOperators[0]) return left_value + right_value;
+    else if (op[0] == kALUOperators[1]) return left_value - right_value;
+    else if (op[0] == kALUOperators[2]) return left_value * right_value;
+
+    if (right_value == 0) {
+        string err_msg = "> Division by zero.";
+        throw err_msg;
+    } else if (left_value == INT_MIN && right_value == -1) {
+        string err_msg = "> Division result is out of range.";
+        throw err_msg;
+    }
+
+    return left_value / right_value;
+}
@@ -0,0 +1,55 @@
+// File: ALEProcess.h
+// Resumable emulation of a single program for Assembly Language Emulator.
+
+#ifndef ALEProcess_Class
+#define ALEProcess_Class
+
+#include <string>
+#include "ALEDatabase.h"
+#include "ALEMemory.h"
+
+using namespace std;
+
+class ALEProcess {
+    public:
+        // Prepares emulation of given program from it's first instruction.
+        ALEProcess(ALEDatabase* prog_data, ALEMemory* prog_memory, bool print_mode);
+
+        // Destructor isn't needed.
+        ~ALEProcess();
+
+        // Executes at most 'quantum' instructions and returns true if the program
+        // finished. Current instruction and call depth are kept between calls, so
+        // the next call continues where this one stopped.
+        bool Run(int quantum);
+
+        // Stops the program because of given error(E.g. thrown by Run).
+        void Abort(string err_msg);
+
+        // Checks if the program finished, returned or failed.
+        bool HasFinished();
+
+        // Checks if the program reached the final RET instruction.
+        bool HasReturned();
+
+        // Returns value of 'RV' at the final RET instruction.
+        int GetRetValue();
+
+        // Returns error message of the aborted program, or empty string.
+        string GetErrorMessage();
+    private:
+        // Executes current instruction and moves to the next one.
+        void Step();
+
+        ALEDatabase* prog_data; // Program being emulated.
+        ALEMemory* prog_memory; // Registers and address space of the program.
+        bool print_mode; // Prints each instruction before execution.
+        int index; // Current instruction index.
+        int num_of_calls; // Current call depth.
+        bool finished;
+        bool returned;
+        int ret_value;
+        string err_msg;
+};
+
+#endif
@@ -0,0 +1,88 @@
+// File: ALEScheduler.cpp
+// Time-sliced execution of many programs on few threads for Assembly Language Emulator.
+
+#include "ALEScheduler.h"
+
+ALEScheduler::ALEScheduler(int thread_count, int quantum) {
+    if (thread_count <= 0) {
+        string err_msg = "> Number of threads must be positive.";
+        throw err_msg;
+    }
+
+    if (quantum <= 0) {
+        string err_msg = "> Quantum must be positive.";
+        throw err_msg;
+    }
+
+    this->quantum = quantum;
+    stopping = false;
+
+    for (int i = 0; i < thread_count; i++) {
+        workers.push_back(thread(&ALEScheduler::Work, this));
+    }
+}
+
+ALEScheduler::~ALEScheduler() {
+    {
+        lock_guard<mutex> lock(queue_lock);
+        stopping = true;
+    }
+    queue_changed.notify_all();
+
+    for (int i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+void ALEScheduler::Submit(ALEProcess* process) {
+    {
+        lock_guard<mutex> lock(queue_lock);
+        run_queue.push_back(process);
+        unfinished.insert(process);
+    }
+    queue_changed.notify_one();
+}
+
+void ALEScheduler::Wait(ALEProcess* process) {
+    unique_lock<mutex> lock(queue_lock);
+    while (unfinished.find(process) != unfinished.end()) process_finished.wait(lock);
+}
+
+void ALEScheduler::WaitAll() {
+    unique_lock<mutex> lock(queue_lock);
+    while (!unfinished.empty()) process_finished.wait(lock);
+}
+
+// Every program gets the same quantum and goes back to the end of the queue, so
+// short programs finish after a few turns no matter how long the others run.
+void ALEScheduler::Work() {
+    while (true) {
+        ALEProcess* process;
+        {
+            unique_lock<mutex> lock(queue_lock);
+            while (run_queue.empty() && !stopping) queue_changed.wait(lock);
+            if (run_queue.empty()) return;
+
+            process = run_queue.front();
+            run_queue.pop_front();
+        }
+
+        bool finished;
+        try {
+            finished = process->Run(quantum);
+        } catch (string err_msg) {
+            process->Abort(err_msg);
+            finished = true;
+        }
+
+        {
+            lock_guard<mutex> lock(queue_lock);
+            if (finished) {
+                unfinished.erase(process);
+                process_finished.notify_all();
+                continue;
+            }
+
+            run_queue.push_back(process);
+        }
+        queue_changed.notify_one();
+    }
+}
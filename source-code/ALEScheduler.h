@@ -0,0 +1,52 @@
+// File: ALEScheduler.h
+// Time-sliced execution of many programs on few threads for Assembly Language Emulator.
+
+#ifndef ALEScheduler_Class
+#define ALEScheduler_Class
+
+#include <vector>
+#include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ALEProcess.h"
+
+using namespace std;
+
+class ALEScheduler {
+    public:
+        // Starts 'thread_count' worker threads which take turns in executing submitted
+        // programs, 'quantum' instructions at a time. Both must be positive.
+        ALEScheduler(int thread_count, int quantum);
+
+        // Finishes submitted programs and stops worker threads.
+        ~ALEScheduler();
+
+        // Adds given program to the end of the run queue. Program must stay alive
+        // until it finishes.
+        void Submit(ALEProcess* process);
+
+        // Waits until given program finishes. Results of a submitted program may be
+        // read only after this or WaitAll returns.
+        void Wait(ALEProcess* process);
+
+        // Waits until every submitted program finishes. Errors of the programs are
+        // stored in them instead of being thrown.
+        void WaitAll();
+    private:
+        // Worker thread: runs a quantum of the first program in the queue and puts
+        // it back to the end if it isn't finished yet.
+        void Work();
+
+        int quantum; // Number of instructions executed at a time.
+        vector<thread> workers; // Worker threads.
+        deque<ALEProcess*> run_queue; // Programs waiting for their turn.
+        set<ALEProcess*> unfinished; // Submitted programs which haven't finished yet.
+        bool stopping; // Set when the scheduler is destroyed.
+        mutex queue_lock;
+        condition_variable queue_changed; // Notifies workers about new programs.
+        condition_variable process_finished; // Notifies Wait and WaitAll.
+};
+
+#endif